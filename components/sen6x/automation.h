@@ -30,5 +30,13 @@ template<typename... Ts> class StartMeasurementAction : public Action<Ts...> {
   SEN5XComponent *sen6x_;
 };
 
+class ThresholdTrigger : public Trigger<> {
+ public:
+  ThresholdTrigger(SEN5XComponent *sen6x, Sen6xChannel channel, ThresholdType type, int32_t threshold,
+                   int32_t hysteresis) {
+    sen6x->add_threshold_rule(this, channel, type, threshold, hysteresis);
+  }
+};
+
 }  // namespace sen6x
 }  // namespace esphome
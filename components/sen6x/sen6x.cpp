@@ -3,6 +3,7 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include <cinttypes>
+#include <cstring>
 
 namespace esphome {
 namespace sen6x {
@@ -27,20 +28,20 @@ static const uint16_t SEN5X_CMD_VOC_ALGORITHM_TUNING = 0x60D0;
 static const uint16_t SEN6X_CMD_RESET = 0xD304;
 static const uint16_t SEN6X_CMD_READ_NUMBER_CONCENTRATION = 0x0316;
 
-static uint8_t sen6x_crc8(const uint8_t *data, uint8_t len) {
-  uint8_t crc = 0xFF;
-  for (uint8_t i = 0; i < len; i++) {
-    crc ^= data[i];
-    for (uint8_t b = 0; b < 8; b++) {
-      if (crc & 0x80)
-        crc = (crc << 1) ^ 0x31;
-      else
-        crc <<= 1;
-    }
+// Continues an FNV-1 hash over a C string, so concatenated keys can be hashed without building a std::string.
+// Starting from the FNV-1 offset basis this yields the same value as fnv1_hash() on the concatenation.
+static uint32_t fnv1_hash_append(uint32_t hash, const char *str) {
+  while (*str) {
+    hash *= 16777619UL;
+    hash ^= static_cast<uint8_t>(*str++);
   }
-  return crc;
+  return hash;
 }
 
+// Step delays of the read cycle in ms
+static const uint32_t BASELINE_READ_DELAY = 550;
+static const uint32_t MEASUREMENT_READ_DELAY = 50;
+static const uint32_t NUMBER_CONCENTRATION_READ_DELAY = 50;
 
 void SEN5XComponent::setup() {
   ESP_LOGCONFIG(TAG, "Setting up sen6x...");
@@ -86,7 +87,9 @@ void SEN5XComponent::setup() {
       this->serial_number_[0] = static_cast<bool>(uint16_t(raw_serial_number[0]) & 0xFF);
       this->serial_number_[1] = static_cast<uint16_t>(raw_serial_number[0] & 0xFF);
       this->serial_number_[2] = static_cast<uint16_t>(raw_serial_number[1] >> 8);
-      ESP_LOGD(TAG, "Serial number %02d.%02d.%02d", serial_number_[0], serial_number_[1], serial_number_[2]);
+      snprintf(this->serial_string_, sizeof(this->serial_string_), "%02d.%02d.%02d", serial_number_[0],
+               serial_number_[1], serial_number_[2]);
+      ESP_LOGD(TAG, "Serial number %s", this->serial_string_);
 
       uint16_t raw_product_name[16];
 
@@ -98,55 +101,54 @@ void SEN5XComponent::setup() {
       }
 
       // 2 ASCII bytes are encoded in an int
-      const uint16_t *current_int = raw_product_name;
-      char current_char;
-      uint8_t max = 16;
-      do {
+      uint8_t len = 0;
+      for (uint16_t raw : raw_product_name) {
         // first char
-        current_char = *current_int >> 8;
-        if (current_char) {
-          product_name_.push_back(current_char);
-          // second char
-          current_char = *current_int & 0xFF;
-          if (current_char)
-            product_name_.push_back(current_char);
-        }
-        current_int++;
-      } while (current_char && --max);
+        char current_char = raw >> 8;
+        if (!current_char)
+          break;
+        this->product_name_[len++] = current_char;
+        // second char
+        current_char = raw & 0xFF;
+        if (!current_char)
+          break;
+        this->product_name_[len++] = current_char;
+      }
+      this->product_name_[len] = '\0';
 
       Sen5xType sen6x_type = UNKNOWN;
-      if (product_name_ == "SEN50") {
+      if (strcmp(product_name_, "SEN50") == 0) {
         sen6x_type = SEN50;
       } else {
-        if (product_name_ == "SEN54") {
+        if (strcmp(product_name_, "SEN54") == 0) {
           sen6x_type = SEN54;
         } else {
-          if (product_name_ == "SEN55") {
+          if (strcmp(product_name_, "SEN55") == 0) {
             sen6x_type = SEN55;
           }
         }
-        if (product_name_ == "SEN66" || product_name_ == "") { // emppty name!
-          ESP_LOGD(TAG, "Productname for real: %s", product_name_.c_str());
+        if (strcmp(product_name_, "SEN66") == 0 || product_name_[0] == '\0') { // emppty name!
+          ESP_LOGD(TAG, "Productname for real: %s", product_name_);
           sen6x_type = SEN55; //for now
         }
-        ESP_LOGD(TAG, "Productname %s", product_name_.c_str());
+        ESP_LOGD(TAG, "Productname %s", product_name_);
       }
       if (this->humidity_sensor_ && sen6x_type == SEN50) {
         ESP_LOGE(TAG, "For Relative humidity a SEN54 OR SEN55 is required. You are using a <%s> sensor",
-                 this->product_name_.c_str());
+                 this->product_name_);
         this->humidity_sensor_ = nullptr;  // mark as not used
       }
       if (this->temperature_sensor_ && sen6x_type == SEN50) {
         ESP_LOGE(TAG, "For Temperature a SEN54 OR SEN55 is required. You are using a <%s> sensor",
-                 this->product_name_.c_str());
+                 this->product_name_);
         this->temperature_sensor_ = nullptr;  // mark as not used
       }
       if (this->voc_sensor_ && sen6x_type == SEN50) {
-        ESP_LOGE(TAG, "For VOC a SEN54 OR SEN55 is required. You are using a <%s> sensor", this->product_name_.c_str());
+        ESP_LOGE(TAG, "For VOC a SEN54 OR SEN55 is required. You are using a <%s> sensor", this->product_name_);
         this->voc_sensor_ = nullptr;  // mark as not used
       }
       if (this->nox_sensor_ && sen6x_type != SEN55) {
-        ESP_LOGE(TAG, "For NOx a SEN55 is required. You are using a <%s> sensor", this->product_name_.c_str());
+        ESP_LOGE(TAG, "For NOx a SEN55 is required. You are using a <%s> sensor", this->product_name_);
         this->nox_sensor_ = nullptr;  // mark as not used
       }
 
@@ -165,7 +167,10 @@ void SEN5XComponent::setup() {
         // Hash with compilation time and serial number
         // This ensures the baseline storage is cleared after OTA
         // Serial numbers are unique to each sensor, so mulitple sensors can be used without conflict
-        uint32_t hash = fnv1_hash(App.get_compilation_time() + std::to_string(combined_serial));
+        char serial_key[11];
+        snprintf(serial_key, sizeof(serial_key), "%" PRIu32, combined_serial);
+        uint32_t hash = fnv1_hash_append(2166136261UL, App.get_compilation_time().c_str());
+        hash = fnv1_hash_append(hash, serial_key);
         this->pref_ = global_preferences->make_preference<Sen5xBaselines>(hash, true);
 
         if (this->pref_.load(&this->voc_baselines_storage_)) {
@@ -249,9 +254,9 @@ void SEN5XComponent::dump_config() {
         break;
     }
   }
-  ESP_LOGCONFIG(TAG, "  Productname: %s", this->product_name_.c_str());
+  ESP_LOGCONFIG(TAG, "  Productname: %s", this->product_name_);
   ESP_LOGCONFIG(TAG, "  Firmware version: %d", this->firmware_version_);
-  ESP_LOGCONFIG(TAG, "  Serial number %02d.%02d.%02d", serial_number_[0], serial_number_[1], serial_number_[2]);
+  ESP_LOGCONFIG(TAG, "  Serial number %s", this->serial_string_);
 
   LOG_UPDATE_INTERVAL(this);
   LOG_SENSOR("  ", "PM  ≤1.0", this->pm_1_0_sensor_);
@@ -264,123 +269,252 @@ void SEN5XComponent::dump_config() {
   LOG_SENSOR("  ", "VOC", this->voc_sensor_);  // SEN54 and SEN55 only
   LOG_SENSOR("  ", "NOx", this->nox_sensor_);  // SEN55 only
   LOG_SENSOR("  ", "CO2", this->co2_sensor_);  // SEN66
+  ESP_LOGCONFIG(TAG, "  Threshold rules: %u", (unsigned) this->threshold_rules_.size());
 }
 
 void SEN5XComponent::update() {
   if (!initialized_) {
     return;
   }
+  if (this->read_step_ != READ_STEP_IDLE) {
+    ESP_LOGD(TAG, "Previous read cycle still running, skipping update");
+    return;
+  }
   // Store baselines after defined interval or if the difference between current and stored baseline becomes too
   // much
   if (this->store_baseline_ && this->seconds_since_last_store_ > SHORTEST_BASELINE_STORE_INTERVAL) {
     if (this->write_command(SEN5X_CMD_VOC_ALGORITHM_STATE)) {
-      // run it a bit later to avoid adding a delay here
-      this->set_timeout(550, [this]() {
-        uint16_t states[4];
-        if (this->read_data(states, 4)) {
-          uint32_t state0 = states[0] << 16 | states[1];
-          uint32_t state1 = states[2] << 16 | states[3];
-          if ((uint32_t) std::abs(static_cast<int32_t>(this->voc_baselines_storage_.state0 - state0)) >
-                  MAXIMUM_STORAGE_DIFF ||
-              (uint32_t) std::abs(static_cast<int32_t>(this->voc_baselines_storage_.state1 - state1)) >
-                  MAXIMUM_STORAGE_DIFF) {
-            this->seconds_since_last_store_ = 0;
-            this->voc_baselines_storage_.state0 = state0;
-            this->voc_baselines_storage_.state1 = state1;
-
-            if (this->pref_.save(&this->voc_baselines_storage_)) {
-              ESP_LOGI(TAG, "Stored VOC baseline state0: 0x%04" PRIX32 " ,state1: 0x%04" PRIX32,
-                       this->voc_baselines_storage_.state0, voc_baselines_storage_.state1);
-            } else {
-              ESP_LOGW(TAG, "Could not store VOC baselines");
-            }
-          }
-        }
-      });
+      // read it a bit later to avoid adding a delay here
+      this->read_step_ = READ_STEP_BASELINE;
+      this->read_step_start_ = millis();
+      return;
     }
   }
+  this->start_read_measurement_();
+}
 
+void SEN5XComponent::loop() {
+  if (this->read_step_ == READ_STEP_IDLE) {
+    return;
+  }
+  const uint32_t elapsed = millis() - this->read_step_start_;
+  switch (this->read_step_) {
+    case READ_STEP_BASELINE:
+      if (elapsed < BASELINE_READ_DELAY)
+        return;
+      this->store_baseline_states_();
+      this->start_read_measurement_();
+      break;
+    case READ_STEP_MEASUREMENT:
+      if (elapsed < MEASUREMENT_READ_DELAY)
+        return;
+      this->read_measurement_();
+      break;
+    case READ_STEP_NUMBER_CONCENTRATION:
+      if (elapsed < NUMBER_CONCENTRATION_READ_DELAY)
+        return;
+      this->read_step_ = READ_STEP_IDLE;
+      this->publish_measurements_();
+      break;
+    default:
+      this->read_step_ = READ_STEP_IDLE;
+      break;
+  }
+}
+
+void SEN5XComponent::start_read_measurement_() {
+  this->read_step_ = READ_STEP_IDLE;
   if (!this->write_command(SEN5X_CMD_READ_MEASUREMENT)) {
     this->status_set_warning();
     ESP_LOGD(TAG, "write error read measurement (%d)", this->last_error_);
     return;
   }
-  this->set_timeout(50, [this]() {
-    uint16_t measurements[9];
+  this->read_step_ = READ_STEP_MEASUREMENT;
+  this->read_step_start_ = millis();
+}
 
-    if (!this->read_data(measurements, 9)) {
-      this->status_set_warning();
-      ESP_LOGD(TAG, "read data error (%d)", this->last_error_);
-      return;
+void SEN5XComponent::store_baseline_states_() {
+  uint16_t states[4];
+  if (!this->read_data(states, 4)) {
+    return;
+  }
+  uint32_t state0 = states[0] << 16 | states[1];
+  uint32_t state1 = states[2] << 16 | states[3];
+  if ((uint32_t) std::abs(static_cast<int32_t>(this->voc_baselines_storage_.state0 - state0)) >
+          MAXIMUM_STORAGE_DIFF ||
+      (uint32_t) std::abs(static_cast<int32_t>(this->voc_baselines_storage_.state1 - state1)) >
+          MAXIMUM_STORAGE_DIFF) {
+    this->seconds_since_last_store_ = 0;
+    this->voc_baselines_storage_.state0 = state0;
+    this->voc_baselines_storage_.state1 = state1;
+
+    if (this->pref_.save(&this->voc_baselines_storage_)) {
+      ESP_LOGI(TAG, "Stored VOC baseline state0: 0x%04" PRIX32 " ,state1: 0x%04" PRIX32,
+               this->voc_baselines_storage_.state0, voc_baselines_storage_.state1);
+    } else {
+      ESP_LOGW(TAG, "Could not store VOC baselines");
     }
+  }
+}
 
-    float pm_1_0 = measurements[0] / 10.0;
-    if (measurements[0] == 0xFFFF)
-      pm_1_0 = NAN;
-    float pm_2_5 = (measurements[1] - measurements[0]) / 10.0;
-    if (measurements[1] == 0xFFFF || measurements[0] == 0xFFFF)
-      pm_2_5 = NAN;
-    float pm_4_0 = (measurements[2] - measurements[1]) / 10.0;
-    if (measurements[2] == 0xFFFF || measurements[1] == 0xFFFF)
-      pm_4_0 = NAN;
-    float pm_10_0 = (measurements[3] - measurements[2]) / 10.0;
-    if (measurements[3] == 0xFFFF || measurements[2] == 0xFFFF)
-      pm_10_0 = NAN;
-    float pm_0_10 = measurements[3] / 10.0;
-    if (measurements[3] == 0xFFFF)
-      pm_0_10 = NAN;
-    float humidity = measurements[4] / 100.0;
-    if (measurements[4] == 0xFFFF)
-      humidity = NAN;
-    float temperature = (int16_t) measurements[5] / 200.0;
-    if (measurements[5] == 0xFFFF)
-      temperature = NAN;
-    float voc = measurements[6] / 10.0;
-    if (measurements[6] == 0x7FFF)
-      voc = NAN;
-    float nox = measurements[7] / 10.0;
-    if (measurements[7] == 0x7FFF)
-      nox = NAN;
-    float co2 = measurements[8];
-    if (measurements[8] == 0xFFFF)
-      co2 = NAN;
-
-    // 👉 FIX: Werte werden captured!
-    this->set_timeout(50, [this, pm_1_0, pm_2_5, pm_4_0, pm_10_0, pm_0_10, humidity, temperature, voc, nox, co2]() {
-
-      uint16_t nc05, nc10, nc25, nc40, nc100;
-      if (this->read_number_concentration(&nc05, &nc10, &nc25, &nc40, &nc100)) {
-        if (this->nc_0_5_sensor_ != nullptr) this->nc_0_5_sensor_->publish_state(nc05);
-        if (this->nc_1_0_sensor_ != nullptr) this->nc_1_0_sensor_->publish_state(nc10);
-        if (this->nc_2_5_sensor_ != nullptr) this->nc_2_5_sensor_->publish_state(nc25);
-        if (this->nc_4_0_sensor_ != nullptr) this->nc_4_0_sensor_->publish_state(nc40);
-        if (this->nc_10_0_sensor_ != nullptr) this->nc_10_0_sensor_->publish_state(nc100);
-      }
+void SEN5XComponent::read_measurement_() {
+  this->read_step_ = READ_STEP_IDLE;
+  if (!this->read_data(this->measurements_, 9)) {
+    this->status_set_warning();
+    ESP_LOGD(TAG, "read data error (%d)", this->last_error_);
+    return;
+  }
+  // rules run on the raw frame right away, so local automations do not wait for publishing or filters
+  this->evaluate_threshold_rules_();
+  // the raw frame is kept in measurements_ until the number concentration has been read as well
+  this->read_step_ = READ_STEP_NUMBER_CONCENTRATION;
+  this->read_step_start_ = millis();
+}
 
-      if (this->pm_1_0_sensor_ != nullptr)
-        this->pm_1_0_sensor_->publish_state(pm_1_0);
-      if (this->pm_2_5_sensor_ != nullptr)
-        this->pm_2_5_sensor_->publish_state(pm_2_5);
-      if (this->pm_4_0_sensor_ != nullptr)
-        this->pm_4_0_sensor_->publish_state(pm_4_0);
-      if (this->pm_10_0_sensor_ != nullptr)
-        this->pm_10_0_sensor_->publish_state(pm_10_0);
-      if (this->pm_0_10_sensor_ != nullptr)
-        this->pm_0_10_sensor_->publish_state(pm_0_10);
-      if (this->temperature_sensor_ != nullptr)
-        this->temperature_sensor_->publish_state(temperature);
-      if (this->humidity_sensor_ != nullptr)
-        this->humidity_sensor_->publish_state(humidity);
-      if (this->voc_sensor_ != nullptr)
-        this->voc_sensor_->publish_state(voc);
-      if (this->nox_sensor_ != nullptr)
-        this->nox_sensor_->publish_state(nox);
-      if (this->co2_sensor_ != nullptr)
-        this->co2_sensor_->publish_state(co2);
-
-      this->status_clear_warning();
-    });
-  });
+void SEN5XComponent::publish_measurements_() {
+  const uint16_t *measurements = this->measurements_;
+
+  float pm_1_0 = measurements[0] / 10.0;
+  if (measurements[0] == 0xFFFF)
+    pm_1_0 = NAN;
+  float pm_2_5 = (measurements[1] - measurements[0]) / 10.0;
+  if (measurements[1] == 0xFFFF || measurements[0] == 0xFFFF)
+    pm_2_5 = NAN;
+  float pm_4_0 = (measurements[2] - measurements[1]) / 10.0;
+  if (measurements[2] == 0xFFFF || measurements[1] == 0xFFFF)
+    pm_4_0 = NAN;
+  float pm_10_0 = (measurements[3] - measurements[2]) / 10.0;
+  if (measurements[3] == 0xFFFF || measurements[2] == 0xFFFF)
+    pm_10_0 = NAN;
+  float pm_0_10 = measurements[3] / 10.0;
+  if (measurements[3] == 0xFFFF)
+    pm_0_10 = NAN;
+  float humidity = measurements[4] / 100.0;
+  if (measurements[4] == 0xFFFF)
+    humidity = NAN;
+  float temperature = (int16_t) measurements[5] / 200.0;
+  if (measurements[5] == 0xFFFF)
+    temperature = NAN;
+  float voc = measurements[6] / 10.0;
+  if (measurements[6] == 0x7FFF)
+    voc = NAN;
+  float nox = measurements[7] / 10.0;
+  if (measurements[7] == 0x7FFF)
+    nox = NAN;
+  float co2 = measurements[8];
+  if (measurements[8] == 0xFFFF)
+    co2 = NAN;
+
+  uint16_t nc05, nc10, nc25, nc40, nc100;
+  if (this->read_number_concentration(&nc05, &nc10, &nc25, &nc40, &nc100)) {
+    if (this->nc_0_5_sensor_ != nullptr) this->nc_0_5_sensor_->publish_state(nc05);
+    if (this->nc_1_0_sensor_ != nullptr) this->nc_1_0_sensor_->publish_state(nc10);
+    if (this->nc_2_5_sensor_ != nullptr) this->nc_2_5_sensor_->publish_state(nc25);
+    if (this->nc_4_0_sensor_ != nullptr) this->nc_4_0_sensor_->publish_state(nc40);
+    if (this->nc_10_0_sensor_ != nullptr) this->nc_10_0_sensor_->publish_state(nc100);
+  }
+
+  if (this->pm_1_0_sensor_ != nullptr)
+    this->pm_1_0_sensor_->publish_state(pm_1_0);
+  if (this->pm_2_5_sensor_ != nullptr)
+    this->pm_2_5_sensor_->publish_state(pm_2_5);
+  if (this->pm_4_0_sensor_ != nullptr)
+    this->pm_4_0_sensor_->publish_state(pm_4_0);
+  if (this->pm_10_0_sensor_ != nullptr)
+    this->pm_10_0_sensor_->publish_state(pm_10_0);
+  if (this->pm_0_10_sensor_ != nullptr)
+    this->pm_0_10_sensor_->publish_state(pm_0_10);
+  if (this->temperature_sensor_ != nullptr)
+    this->temperature_sensor_->publish_state(temperature);
+  if (this->humidity_sensor_ != nullptr)
+    this->humidity_sensor_->publish_state(humidity);
+  if (this->voc_sensor_ != nullptr)
+    this->voc_sensor_->publish_state(voc);
+  if (this->nox_sensor_ != nullptr)
+    this->nox_sensor_->publish_state(nox);
+  if (this->co2_sensor_ != nullptr)
+    this->co2_sensor_->publish_state(co2);
+
+  this->status_clear_warning();
+}
+
+bool SEN5XComponent::get_raw_channel_value_(Sen6xChannel channel, int32_t *value) const {
+  const uint16_t *m = this->measurements_;
+  switch (channel) {
+    case CHANNEL_PM_1_0:
+      *value = m[0];
+      return m[0] != 0xFFFF;
+    case CHANNEL_PM_2_5:
+      *value = int32_t(m[1]) - m[0];
+      return m[1] != 0xFFFF && m[0] != 0xFFFF;
+    case CHANNEL_PM_4_0:
+      *value = int32_t(m[2]) - m[1];
+      return m[2] != 0xFFFF && m[1] != 0xFFFF;
+    case CHANNEL_PM_10_0:
+      *value = int32_t(m[3]) - m[2];
+      return m[3] != 0xFFFF && m[2] != 0xFFFF;
+    case CHANNEL_PM_0_10:
+      *value = m[3];
+      return m[3] != 0xFFFF;
+    case CHANNEL_HUMIDITY:
+      *value = m[4];
+      return m[4] != 0xFFFF;
+    case CHANNEL_TEMPERATURE:
+      *value = (int16_t) m[5];
+      return m[5] != 0xFFFF;
+    case CHANNEL_VOC:
+      *value = (int16_t) m[6];
+      return m[6] != 0x7FFF;
+    case CHANNEL_NOX:
+      *value = (int16_t) m[7];
+      return m[7] != 0x7FFF;
+    case CHANNEL_CO2:
+      *value = m[8];
+      return m[8] != 0xFFFF;
+    default:
+      return false;
+  }
+}
+
+void SEN5XComponent::evaluate_threshold_rules_() {
+  for (auto &rule : this->threshold_rules_) {
+    int32_t value;
+    if (!this->get_raw_channel_value_(rule.channel, &value)) {
+      // invalid sample, don't compute a rate across the gap
+      rule.has_last_value = false;
+      continue;
+    }
+    bool fire = false;
+    switch (rule.type) {
+      case THRESHOLD_ABOVE:
+        if (!rule.active && value > rule.threshold) {
+          rule.active = true;
+          fire = true;
+        } else if (rule.active && value < rule.threshold - rule.hysteresis) {
+          rule.active = false;
+        }
+        break;
+      case THRESHOLD_BELOW:
+        if (!rule.active && value < rule.threshold) {
+          rule.active = true;
+          fire = true;
+        } else if (rule.active && value > rule.threshold + rule.hysteresis) {
+          rule.active = false;
+        }
+        break;
+      case THRESHOLD_RATE_OF_CHANGE:
+        // positive threshold fires on a rise, negative one on a drop of at least that much per sample
+        if (rule.has_last_value) {
+          int32_t delta = value - rule.last_value;
+          fire = rule.threshold > 0 ? delta >= rule.threshold : delta <= rule.threshold;
+        }
+        break;
+    }
+    rule.last_value = value;
+    rule.has_last_value = true;
+    if (fire)
+      rule.trigger->trigger();
+  }
 }
 
 bool SEN5XComponent::write_tuning_parameters_(uint16_t i2c_command, const GasTuning &tuning) {
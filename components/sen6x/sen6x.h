@@ -1,5 +1,6 @@
 #pragma once
 
+#include "esphome/core/automation.h"
 #include "esphome/core/component.h"
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/sensirion_common/i2c_sensirion.h"
@@ -30,6 +31,39 @@ struct Sen5xBaselines {
 } PACKED;  // NOLINT
 
 
+// Measurement channels of the read frame that threshold rules can watch.
+// Like the published sensors, PM_2_5/PM_4_0/PM_10_0 are size bands (e.g. 1.0-2.5 µm), PM_0_10 is total ≤10 µm.
+enum Sen6xChannel : uint8_t {
+  CHANNEL_PM_1_0,
+  CHANNEL_PM_2_5,
+  CHANNEL_PM_4_0,
+  CHANNEL_PM_10_0,
+  CHANNEL_PM_0_10,
+  CHANNEL_HUMIDITY,
+  CHANNEL_TEMPERATURE,
+  CHANNEL_VOC,
+  CHANNEL_NOX,
+  CHANNEL_CO2,
+};
+
+enum ThresholdType : uint8_t {
+  THRESHOLD_ABOVE,
+  THRESHOLD_BELOW,
+  THRESHOLD_RATE_OF_CHANGE,
+};
+
+// Threshold, hysteresis and rate are given in raw sensor units (already scaled by sensor.py)
+struct ThresholdRule {
+  Trigger<> *trigger;
+  int32_t threshold;
+  int32_t hysteresis;
+  int32_t last_value;
+  Sen6xChannel channel;
+  ThresholdType type;
+  bool active;
+  bool has_last_value;
+};
+
 struct GasTuning {
   uint16_t index_offset;
   uint16_t learning_time_offset_hours;
@@ -51,8 +85,11 @@ class SEN5XComponent : public PollingComponent, public sensirion_common::Sensiri
   void setup() override;
   void dump_config() override;
   void update() override;
+  void loop() override;
 
   enum Sen5xType { SEN50, SEN54, SEN55, UNKNOWN };
+  // Steps of the non-blocking read cycle driven from loop()
+  enum ReadStep : uint8_t { READ_STEP_IDLE, READ_STEP_BASELINE, READ_STEP_MEASUREMENT, READ_STEP_NUMBER_CONCENTRATION };
 
   void set_pm_1_0_sensor(sensor::Sensor *pm_1_0) { pm_1_0_sensor_ = pm_1_0; }
   void set_pm_2_5_sensor(sensor::Sensor *pm_2_5) { pm_2_5_sensor_ = pm_2_5; }
@@ -103,6 +140,16 @@ class SEN5XComponent : public PollingComponent, public sensirion_common::Sensiri
     temp_comp.time_constant = time_constant;
     temperature_compensation_ = temp_comp;
   }
+  void add_threshold_rule(Trigger<> *trigger, Sen6xChannel channel, ThresholdType type, int32_t threshold,
+                          int32_t hysteresis) {
+    ThresholdRule rule{};
+    rule.trigger = trigger;
+    rule.threshold = threshold;
+    rule.hysteresis = hysteresis;
+    rule.channel = channel;
+    rule.type = type;
+    threshold_rules_.push_back(rule);
+  }
   bool start_measurement();
   bool stop_measurement();
   bool start_fan_cleaning();
@@ -111,18 +158,20 @@ class SEN5XComponent : public PollingComponent, public sensirion_common::Sensiri
                                uint16_t *nc25, uint16_t *nc40,
                                uint16_t *nc100);
 
-  std::string get_product_name() const { return product_name_; }
+  const char *get_product_name() const { return product_name_; }
   uint16_t get_firmware_version() const { return firmware_version_; }
-  std::string get_serial_string() const {
-    char buf[32];
-    sprintf(buf, "%02d.%02d.%02d", serial_number_[0], serial_number_[1], serial_number_[2]);
-    return std::string(buf);
-  }
+  const char *get_serial_string() const { return serial_string_; }
   bool is_measuring() const { return this->is_measuring_; }
 
  protected:
   bool write_tuning_parameters_(uint16_t i2c_command, const GasTuning &tuning);
   bool write_temperature_compensation_(const TemperatureCompensation &compensation);
+  void start_read_measurement_();
+  void store_baseline_states_();
+  void read_measurement_();
+  void publish_measurements_();
+  bool get_raw_channel_value_(Sen6xChannel channel, int32_t *value) const;
+  void evaluate_threshold_rules_();
   ERRORCODE error_code_;
   bool initialized_{false};
   sensor::Sensor *pm_1_0_sensor_{nullptr};
@@ -144,17 +193,27 @@ class SEN5XComponent : public PollingComponent, public sensirion_common::Sensiri
   sensor::Sensor *nc_4_0_sensor_{nullptr};
   sensor::Sensor *nc_10_0_sensor_{nullptr};
 
-  std::string product_name_;
+  // 16 words of 2 ASCII chars each plus terminator
+  char product_name_[33]{};
   uint8_t serial_number_[4];
+  // "255.255.255" plus terminator
+  char serial_string_[12]{};
   uint16_t firmware_version_;
   Sen5xBaselines voc_baselines_storage_;
-  bool store_baseline_;
-  uint32_t seconds_since_last_store_;
+  bool store_baseline_{false};
+  uint32_t seconds_since_last_store_{0};
   ESPPreferenceObject pref_;
   optional<GasTuning> voc_tuning_params_;
   optional<GasTuning> nox_tuning_params_;
   optional<TemperatureCompensation> temperature_compensation_;
 
+  // State of the current read cycle, advanced from loop() instead of per-poll scheduler lambdas
+  ReadStep read_step_{READ_STEP_IDLE};
+  uint32_t read_step_start_{0};
+  uint16_t measurements_[9];
+  // Added from generated code before setup; each sample updates the per-rule state in place, so it never grows
+  std::vector<ThresholdRule> threshold_rules_;
+
   bool is_measuring_ = true;   // Sensor läuft beim Boot immer → Default true
 
 };
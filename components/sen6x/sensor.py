@@ -1,9 +1,13 @@
+import math
+
 from esphome import automation
 from esphome.automation import maybe_simple_id
 import esphome.codegen as cg
 from esphome.components import i2c, sensirion_common, sensor
 import esphome.config_validation as cv
 from esphome.const import (
+    CONF_ABOVE,
+    CONF_BELOW,
     CONF_HUMIDITY,
     CONF_ID,
     CONF_OFFSET,
@@ -15,6 +19,7 @@ from esphome.const import (
     CONF_STORE_BASELINE,
     CONF_TEMPERATURE,
     CONF_TEMPERATURE_COMPENSATION,
+    CONF_TRIGGER_ID,
     DEVICE_CLASS_CARBON_DIOXIDE,
     DEVICE_CLASS_AQI,
     DEVICE_CLASS_HUMIDITY,
@@ -48,14 +53,23 @@ StartMeasurementAction = sen6x_ns.class_("StartMeasurementAction", automation.Ac
 StopMeasurementAction = sen6x_ns.class_("StopMeasurementAction", automation.Action)
 StartFanAction = sen6x_ns.class_("StartFanAction", automation.Action)
 
+# Triggers
+ThresholdTrigger = sen6x_ns.class_("ThresholdTrigger", automation.Trigger.template())
+Sen6xChannel = sen6x_ns.enum("Sen6xChannel")
+ThresholdType = sen6x_ns.enum("ThresholdType")
+
 CONF_ALGORITHM_TUNING = "algorithm_tuning"
 CONF_GAIN_FACTOR = "gain_factor"
 CONF_GATING_MAX_DURATION_MINUTES = "gating_max_duration_minutes"
+CONF_HYSTERESIS = "hysteresis"
 CONF_INDEX_OFFSET = "index_offset"
 CONF_LEARNING_TIME_GAIN_HOURS = "learning_time_gain_hours"
 CONF_LEARNING_TIME_OFFSET_HOURS = "learning_time_offset_hours"
 CONF_NORMALIZED_OFFSET_SLOPE = "normalized_offset_slope"
+CONF_MEASUREMENT = "measurement"
 CONF_NOX = "nox"
+CONF_ON_THRESHOLD = "on_threshold"
+CONF_RATE_OF_CHANGE = "rate_of_change"
 CONF_STD_INITIAL = "std_initial"
 CONF_TIME_CONSTANT = "time_constant"
 CONF_VOC = "voc"
@@ -91,6 +105,69 @@ GAS_SENSOR = cv.Schema(
 )
 
 
+CONF_PM_0_10 = "pm_0_10"
+
+# channel enum and factor from published value to raw frame units.
+# pm_2_5, pm_4_0 and pm_10_0 are size bands (e.g. 1.0-2.5 µm) like the published
+# sensors, pm_0_10 is the total mass concentration of all particles ≤10 µm.
+THRESHOLD_CHANNELS = {
+    CONF_PM_1_0: (Sen6xChannel.CHANNEL_PM_1_0, 10),
+    CONF_PM_2_5: (Sen6xChannel.CHANNEL_PM_2_5, 10),
+    CONF_PM_4_0: (Sen6xChannel.CHANNEL_PM_4_0, 10),
+    CONF_PM_10_0: (Sen6xChannel.CHANNEL_PM_10_0, 10),
+    CONF_PM_0_10: (Sen6xChannel.CHANNEL_PM_0_10, 10),
+    CONF_HUMIDITY: (Sen6xChannel.CHANNEL_HUMIDITY, 100),
+    CONF_TEMPERATURE: (Sen6xChannel.CHANNEL_TEMPERATURE, 200),
+    CONF_VOC: (Sen6xChannel.CHANNEL_VOC, 10),
+    CONF_NOX: (Sen6xChannel.CHANNEL_NOX, 10),
+    CONF_CO2: (Sen6xChannel.CHANNEL_CO2, 1),
+}
+
+
+def validate_threshold(config):
+    _, scale = THRESHOLD_CHANNELS[config[CONF_MEASUREMENT]]
+    if CONF_HYSTERESIS in config and CONF_RATE_OF_CHANGE in config:
+        raise cv.Invalid(
+            f"'{CONF_HYSTERESIS}' can only be used with '{CONF_ABOVE}' or '{CONF_BELOW}'"
+        )
+    # the rule compares raw integers, a rate or hysteresis below one raw step would become 0
+    for key in (CONF_RATE_OF_CHANGE, CONF_HYSTERESIS):
+        if key not in config:
+            continue
+        value = abs(config[key])
+        if value * scale < 1 - 1e-9 and (key == CONF_RATE_OF_CHANGE or value > 0):
+            raise cv.Invalid(
+                f"'{key}' is below the resolution of "
+                f"'{config[CONF_MEASUREMENT]}', the smallest allowed step is {1 / scale:g}"
+            )
+    return config
+
+
+def to_raw(value, scale, rounding):
+    """Convert a published value to raw frame units, rounding with floor or ceil."""
+    raw = value * scale
+    # don't let float error like 0.29 * 100 = 28.999... move a whole raw step
+    if abs(raw - round(raw)) < 1e-6:
+        return int(round(raw))
+    return int(rounding(raw))
+
+
+THRESHOLD_SCHEMA = automation.validate_automation(
+    {
+        cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(ThresholdTrigger),
+        cv.Required(CONF_MEASUREMENT): cv.one_of(*THRESHOLD_CHANNELS, lower=True),
+        cv.Optional(CONF_ABOVE): cv.float_,
+        cv.Optional(CONF_BELOW): cv.float_,
+        cv.Optional(CONF_RATE_OF_CHANGE): cv.float_,
+        cv.Optional(CONF_HYSTERESIS): cv.positive_float,
+    },
+    cv.All(
+        cv.has_exactly_one_key(CONF_ABOVE, CONF_BELOW, CONF_RATE_OF_CHANGE),
+        validate_threshold,
+    ),
+)
+
+
 def float_previously_pct(value):
     if isinstance(value, str) and "%" in value:
         raise cv.Invalid(
@@ -209,6 +286,8 @@ CONFIG_SCHEMA = (
                 accuracy_decimals=0,
                 state_class=STATE_CLASS_MEASUREMENT,
             ),
+            cv.Optional(CONF_ON_THRESHOLD): THRESHOLD_SCHEMA,
+        }
     )
     .extend(cv.polling_component_schema("60s"))
     .extend(i2c.i2c_device_schema(0x6B))
@@ -306,6 +385,39 @@ async def to_code(config):
         sens = await sensor.new_sensor(config[CONF_NC_10_0])
         cg.add(var.set_nc_10_0_sensor(sens))
 
+    # Schwellwert-Trigger, ausgewertet auf den Rohwerten
+    for conf in config.get(CONF_ON_THRESHOLD, []):
+        channel, scale = THRESHOLD_CHANNELS[conf[CONF_MEASUREMENT]]
+        hysteresis = conf.get(CONF_HYSTERESIS, 0)
+        # Raw values are integers, so "value > above" means raw > floor(above) and
+        # "value < below" means raw < ceil(below). The re-arm point is converted the
+        # same way and hysteresis passed as its raw distance to the threshold.
+        if CONF_ABOVE in conf:
+            rule_type = ThresholdType.THRESHOLD_ABOVE
+            threshold = to_raw(conf[CONF_ABOVE], scale, math.floor)
+            rearm = to_raw(conf[CONF_ABOVE] - hysteresis, scale, math.ceil)
+            hysteresis_raw = threshold - rearm
+        elif CONF_BELOW in conf:
+            rule_type = ThresholdType.THRESHOLD_BELOW
+            threshold = to_raw(conf[CONF_BELOW], scale, math.ceil)
+            rearm = to_raw(conf[CONF_BELOW] + hysteresis, scale, math.floor)
+            hysteresis_raw = rearm - threshold
+        else:
+            rule_type = ThresholdType.THRESHOLD_RATE_OF_CHANGE
+            # a rise (drop) of at least the rate means a raw delta of at least ceil (floor)
+            rate = conf[CONF_RATE_OF_CHANGE]
+            threshold = to_raw(rate, scale, math.ceil if rate > 0 else math.floor)
+            hysteresis_raw = 0
+        trigger = cg.new_Pvariable(
+            conf[CONF_TRIGGER_ID],
+            var,
+            channel,
+            rule_type,
+            threshold,
+            hysteresis_raw,
+        )
+        await automation.build_automation(trigger, [], conf)
+
 
 SEN5X_ACTION_SCHEMA = maybe_simple_id(
     {
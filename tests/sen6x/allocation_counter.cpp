@@ -0,0 +1,40 @@
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace esphome {
+namespace sen6x {
+namespace testing {
+
+bool count_allocations = false;
+unsigned allocation_count = 0;
+
+}  // namespace testing
+}  // namespace sen6x
+}  // namespace esphome
+
+using esphome::sen6x::testing::allocation_count;
+using esphome::sen6x::testing::count_allocations;
+
+static void *counted_alloc(std::size_t size) {
+  if (count_allocations)
+    allocation_count++;
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void *operator new(std::size_t size) { return counted_alloc(size); }
+void *operator new[](std::size_t size) { return counted_alloc(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  if (count_allocations)
+    allocation_count++;
+  return std::malloc(size == 0 ? 1 : size);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
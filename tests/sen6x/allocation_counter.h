@@ -0,0 +1,13 @@
+#pragma once
+
+namespace esphome {
+namespace sen6x {
+namespace testing {
+
+// Counts global operator new calls while enabled (see allocation_counter.cpp)
+extern bool count_allocations;
+extern unsigned allocation_count;
+
+}  // namespace testing
+}  // namespace sen6x
+}  // namespace esphome
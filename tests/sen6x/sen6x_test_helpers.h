@@ -0,0 +1,52 @@
+#pragma once
+#include "sen6x/sen6x.h"
+#include "esphome/core/hal.h"
+
+namespace esphome {
+namespace sen6x {
+namespace testing {
+
+static const uint16_t CMD_GET_DATA_READY_STATUS = 0x0202;
+static const uint16_t CMD_GET_FIRMWARE_VERSION = 0xD100;
+static const uint16_t CMD_GET_PRODUCT_NAME = 0xD014;
+static const uint16_t CMD_GET_SERIAL_NUMBER = 0xD033;
+static const uint16_t CMD_READ_MEASUREMENT = 0x0300;
+static const uint16_t CMD_READ_NUMBER_CONCENTRATION = 0x0316;
+
+// Exposes the protected read frame and rule evaluation to the tests
+class TestSEN5XComponent : public SEN5XComponent {
+ public:
+  using SEN5XComponent::evaluate_threshold_rules_;
+  using SEN5XComponent::measurements_;
+
+  void set_measurement_response(const uint16_t (&frame)[9]) { this->set_response(CMD_READ_MEASUREMENT, frame, 9); }
+
+  // Answers the setup sequence of a SEN66 that is not measuring yet
+  void prepare_setup_responses() {
+    this->set_store_baseline(false);
+    const uint16_t ready[1] = {0};
+    const uint16_t serial[3] = {0x0102, 0x0300, 0};
+    // "SEN66", rest zero
+    const uint16_t name[16] = {0x5345, 0x4E36, 0x3600};
+    const uint16_t firmware[1] = {0x0400};
+    const uint16_t nc[5] = {10, 20, 30, 40, 50};
+    this->set_response(CMD_GET_DATA_READY_STATUS, ready, 1);
+    this->set_response(CMD_GET_SERIAL_NUMBER, serial, 3);
+    this->set_response(CMD_GET_PRODUCT_NAME, name, 16);
+    this->set_response(CMD_GET_FIRMWARE_VERSION, firmware, 1);
+    this->set_response(CMD_READ_NUMBER_CONCENTRATION, nc, 5);
+  }
+
+  // Drives one poll through update() and loop() until the read cycle is back to idle
+  void run_cycle() {
+    this->update();
+    for (int i = 0; i < 100 && this->read_step_ != READ_STEP_IDLE; i++) {
+      stub_millis += 10;
+      this->loop();
+    }
+  }
+};
+
+}  // namespace testing
+}  // namespace sen6x
+}  // namespace esphome
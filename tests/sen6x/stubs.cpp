@@ -0,0 +1,10 @@
+#include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/preferences.h"
+
+namespace esphome {
+uint32_t stub_millis = 0;
+Application App;
+static ESPPreferences stub_preferences;
+ESPPreferences *global_preferences = &stub_preferences;
+}  // namespace esphome
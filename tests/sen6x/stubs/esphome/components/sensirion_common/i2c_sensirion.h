@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+namespace esphome {
+namespace sensirion_common {
+
+// Host stub: every read returns the words queued for the last written command.
+struct StubResponse {
+  uint16_t command;
+  uint16_t words[16];
+  uint8_t len;
+};
+
+class SensirionI2CDevice {
+ public:
+  static const uint8_t MAX_RESPONSES = 16;
+
+  void set_response(uint16_t command, const uint16_t *words, uint8_t len) {
+    StubResponse *slot = this->find_response_(command);
+    if (slot == nullptr)
+      slot = &this->responses_[this->response_count_++];
+    slot->command = command;
+    slot->len = len;
+    memcpy(slot->words, words, len * sizeof(uint16_t));
+  }
+  uint16_t last_command() const { return this->last_command_; }
+
+ protected:
+  bool write_command(uint16_t command) {
+    this->last_command_ = command;
+    return true;
+  }
+  bool write_command(uint16_t command, const uint16_t *, uint8_t) { return this->write_command(command); }
+  bool read_data(uint16_t *data, uint8_t len) {
+    const StubResponse *slot = this->find_response_(this->last_command_);
+    if (slot == nullptr || slot->len < len) {
+      this->last_error_ = 1;
+      return false;
+    }
+    memcpy(data, slot->words, len * sizeof(uint16_t));
+    return true;
+  }
+  bool read_data(uint16_t &data) { return this->read_data(&data, 1); }
+  bool get_register(uint16_t command, uint16_t *data, uint8_t len, uint8_t) {
+    return this->write_command(command) && this->read_data(data, len);
+  }
+  bool get_register(uint16_t command, uint16_t &data, uint8_t) {
+    return this->write_command(command) && this->read_data(data);
+  }
+
+  StubResponse *find_response_(uint16_t command) {
+    for (uint8_t i = 0; i < this->response_count_; i++) {
+      if (this->responses_[i].command == command)
+        return &this->responses_[i];
+    }
+    return nullptr;
+  }
+
+  StubResponse responses_[MAX_RESPONSES]{};
+  uint8_t response_count_{0};
+  uint16_t last_command_{0};
+  int last_error_{0};
+};
+
+}  // namespace sensirion_common
+}  // namespace esphome
+
+#define LOG_I2C_DEVICE(this) (void) (this)
@@ -0,0 +1,18 @@
+#pragma once
+#include <cmath>
+
+namespace esphome {
+namespace sensor {
+class Sensor {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    this->publish_count++;
+  }
+  float state{NAN};
+  unsigned publish_count{0};
+};
+}  // namespace sensor
+}  // namespace esphome
+
+#define LOG_SENSOR(prefix, type, obj) (void) (obj)
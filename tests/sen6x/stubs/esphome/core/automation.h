@@ -0,0 +1,19 @@
+#pragma once
+
+namespace esphome {
+// Host stub: counts firings instead of running an automation.
+template<typename... Ts> class Trigger {
+ public:
+  void trigger(Ts... x) { this->fired_++; }
+  unsigned fired() const { return this->fired_; }
+
+ protected:
+  unsigned fired_{0};
+};
+
+template<typename... Ts> class Action {
+ public:
+  virtual ~Action() = default;
+  virtual void play(Ts... x) = 0;
+};
+}  // namespace esphome
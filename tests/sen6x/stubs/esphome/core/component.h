@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "esphome/core/helpers.h"
+
+#define PACKED __attribute__((packed))
+
+namespace esphome {
+namespace setup_priority {
+const float DATA = 600.0f;
+}  // namespace setup_priority
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return 0.0f; }
+  bool is_failed() const { return this->failed_; }
+  bool status_has_warning() const { return this->warning_; }
+
+  // Host stub: runs every pending timeout, including ones scheduled while running.
+  void run_pending_timeouts() {
+    while (!this->timeouts_.empty()) {
+      auto pending = std::move(this->timeouts_);
+      this->timeouts_.clear();
+      for (auto &f : pending)
+        f();
+    }
+  }
+
+ protected:
+  void set_timeout(uint32_t, std::function<void()> &&f) { this->timeouts_.push_back(std::move(f)); }
+  void mark_failed() { this->failed_ = true; }
+  void status_set_warning() { this->warning_ = true; }
+  void status_clear_warning() { this->warning_ = false; }
+
+  bool failed_{false};
+  bool warning_{false};
+  std::vector<std::function<void()>> timeouts_;
+};
+
+class PollingComponent : public Component {
+ public:
+  virtual void update() = 0;
+  void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+
+ protected:
+  uint32_t update_interval_{60000};
+};
+}  // namespace esphome
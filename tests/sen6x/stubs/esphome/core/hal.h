@@ -0,0 +1,9 @@
+#pragma once
+#include <cstdint>
+
+namespace esphome {
+// Host stub: time only advances when a test sets it.
+extern uint32_t stub_millis;
+inline uint32_t millis() { return stub_millis; }
+inline void delay(uint32_t ms) { stub_millis += ms; }
+}  // namespace esphome
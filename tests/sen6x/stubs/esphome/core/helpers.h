@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace esphome {
+template<typename T> using optional = std::optional<T>;
+
+inline uint32_t encode_uint24(uint8_t byte1, uint8_t byte2, uint8_t byte3) {
+  return (uint32_t(byte1) << 16) | (uint32_t(byte2) << 8) | uint32_t(byte3);
+}
+
+inline uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= c;
+  }
+  return hash;
+}
+}  // namespace esphome
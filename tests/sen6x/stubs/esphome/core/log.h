@@ -0,0 +1,20 @@
+#pragma once
+// Host stub: log calls are type-checked against their format string but print nothing.
+#include <cstdio>
+
+namespace esphome {
+inline void esp_log_check(const char *, ...) __attribute__((format(printf, 1, 2)));
+inline void esp_log_check(const char *, ...) {}
+}  // namespace esphome
+
+#define ESP_LOG_STUB(tag, format, ...) \
+  do { \
+    (void) (tag); \
+    ::esphome::esp_log_check(format, ##__VA_ARGS__); \
+  } while (0)
+#define ESP_LOGE(tag, ...) ESP_LOG_STUB(tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ESP_LOG_STUB(tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ESP_LOG_STUB(tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ESP_LOG_STUB(tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ESP_LOG_STUB(tag, __VA_ARGS__)
+#define LOG_UPDATE_INTERVAL(this) (void) (this)
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+namespace esphome {
+// Host stub: a single in-memory slot.
+class ESPPreferenceObject {
+ public:
+  template<typename T> bool save(const T *src) {
+    static_assert(sizeof(T) <= sizeof(data_), "preference too large");
+    memcpy(this->data_, src, sizeof(T));
+    this->saved_ = true;
+    return true;
+  }
+  template<typename T> bool load(T *dest) {
+    if (!this->saved_)
+      return false;
+    memcpy(dest, this->data_, sizeof(T));
+    return true;
+  }
+
+ protected:
+  uint8_t data_[32];
+  bool saved_{false};
+};
+
+class ESPPreferences {
+ public:
+  template<typename T> ESPPreferenceObject make_preference(uint32_t, bool) { return {}; }
+};
+extern ESPPreferences *global_preferences;
+}  // namespace esphome
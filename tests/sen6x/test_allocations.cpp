@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "allocation_counter.h"
+#include "sen6x_test_helpers.h"
+
+namespace esphome {
+namespace sen6x {
+namespace testing {
+
+TEST(Sen6xAllocations, SteadyStateCycleDoesNotAllocate) {
+  TestSEN5XComponent sen;
+  sensor::Sensor pm_2_5, co2, nc_0_5;
+  sen.set_pm_2_5_sensor(&pm_2_5);
+  sen.set_co2_sensor(&co2);
+  sen.set_nc_0_5_sensor(&nc_0_5);
+
+  sen.prepare_setup_responses();
+  const uint16_t low[9] = {10, 20, 30, 40, 5000, 4000, 100, 10, 800};
+  const uint16_t high[9] = {10, 120, 130, 140, 5000, 4000, 100, 10, 1500};
+  sen.set_measurement_response(low);
+
+  sen.setup();
+  sen.run_pending_timeouts();
+  ASSERT_FALSE(sen.is_failed());
+  EXPECT_STREQ(sen.get_product_name(), "SEN66");
+  EXPECT_STREQ(sen.get_serial_string(), "01.02.03");
+
+  // first cycle after setup
+  sen.run_cycle();
+  ASSERT_EQ(co2.publish_count, 1u);
+
+  allocation_count = 0;
+  count_allocations = true;
+  for (int i = 0; i < 10; i++) {
+    sen.set_measurement_response(i % 2 ? high : low);
+    sen.run_cycle();
+  }
+  count_allocations = false;
+
+  EXPECT_EQ(allocation_count, 0u);
+  EXPECT_EQ(co2.publish_count, 11u);
+  EXPECT_EQ(nc_0_5.publish_count, 11u);
+  EXPECT_FLOAT_EQ(co2.state, 1500.0f);
+  EXPECT_FLOAT_EQ(pm_2_5.state, 11.0f);
+}
+
+}  // namespace testing
+}  // namespace sen6x
+}  // namespace esphome
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "allocation_counter.h"
+#include "sen6x/automation.h"
+#include "sen6x_test_helpers.h"
+
+namespace esphome {
+namespace sen6x {
+namespace testing {
+
+static const uint16_t INVALID = 0xFFFF;
+
+struct ThresholdCase {
+  const char *name;
+  Sen6xChannel channel;
+  ThresholdType type;
+  int32_t threshold;
+  int32_t hysteresis;
+  // one raw frame word per sample, written to the channel's slot
+  std::vector<uint16_t> samples;
+  // cumulative trigger count after each sample
+  std::vector<unsigned> fired;
+};
+
+class ThresholdRulesTest : public ::testing::TestWithParam<ThresholdCase> {};
+
+TEST_P(ThresholdRulesTest, FiresOnExpectedSamples) {
+  const ThresholdCase &c = GetParam();
+  ASSERT_EQ(c.samples.size(), c.fired.size());
+  TestSEN5XComponent sen;
+  ThresholdTrigger trigger(&sen, c.channel, c.type, c.threshold, c.hysteresis);
+
+  for (size_t i = 0; i < c.samples.size(); i++) {
+    for (auto &word : sen.measurements_)
+      word = 0;
+    switch (c.channel) {
+      case CHANNEL_CO2:
+        sen.measurements_[8] = c.samples[i];
+        break;
+      case CHANNEL_TEMPERATURE:
+        sen.measurements_[5] = c.samples[i];
+        break;
+      case CHANNEL_PM_2_5:
+        // band 1.0-2.5 µm is m[1] - m[0]
+        sen.measurements_[0] = 100;
+        sen.measurements_[1] = c.samples[i] == INVALID ? INVALID : uint16_t(100 + c.samples[i]);
+        break;
+      case CHANNEL_PM_0_10:
+        sen.measurements_[3] = c.samples[i];
+        break;
+      default:
+        FAIL() << "channel not covered by this test";
+    }
+    sen.evaluate_threshold_rules_();
+    EXPECT_EQ(trigger.fired(), c.fired[i]) << c.name << ", sample " << i;
+  }
+}
+
+static uint16_t celsius(float value) { return uint16_t(int16_t(value * 200)); }
+
+INSTANTIATE_TEST_SUITE_P(
+    Sen6x, ThresholdRulesTest,
+    ::testing::Values(
+        // fires once on the crossing, re-arms only below threshold - hysteresis
+        ThresholdCase{"above_hysteresis",
+                      CHANNEL_CO2,
+                      THRESHOLD_ABOVE,
+                      1200,
+                      100,
+                      {1000, 1201, 1300, 1150, 1250, 1099, 1201},
+                      {0, 1, 1, 1, 1, 1, 2}},
+        // equal to the threshold neither counts as above nor re-arms
+        ThresholdCase{"above_equal", CHANNEL_CO2, THRESHOLD_ABOVE, 1200, 0, {1200, 1201, 1200, 1199, 1201},
+                      {0, 1, 1, 1, 2}},
+        // an invalid sample keeps the armed state
+        ThresholdCase{"above_invalid", CHANNEL_CO2, THRESHOLD_ABOVE, 1200, 0, {1300, INVALID, 1300}, {1, 1, 1}},
+        // signed channel: below 18 °C with 1 °C hysteresis
+        ThresholdCase{"below_signed",
+                      CHANNEL_TEMPERATURE,
+                      THRESHOLD_BELOW,
+                      18 * 200,
+                      200,
+                      {celsius(20), celsius(-5), celsius(18.5), celsius(19.5), celsius(17)},
+                      {0, 1, 1, 1, 2}},
+        // positive rate fires on rises of at least the rate, not on drops
+        ThresholdCase{"rate_rise", CHANNEL_PM_0_10, THRESHOLD_RATE_OF_CHANGE, 50, 0, {100, 149, 199, 300, 100, 150},
+                      {0, 0, 1, 2, 2, 3}},
+        // negative rate fires on drops only
+        ThresholdCase{"rate_drop", CHANNEL_CO2, THRESHOLD_RATE_OF_CHANGE, -100, 0, {1000, 900, 850, 1000, 899},
+                      {0, 1, 1, 1, 2}},
+        // an invalid sample resets the rate baseline
+        ThresholdCase{"rate_invalid_reset", CHANNEL_PM_0_10, THRESHOLD_RATE_OF_CHANGE, 50, 0,
+                      {100, INVALID, 200, 260}, {0, 0, 0, 1}},
+        // rate on a band channel uses the band difference, not the cumulative word
+        ThresholdCase{"rate_band", CHANNEL_PM_2_5, THRESHOLD_RATE_OF_CHANGE, 50, 0, {0, 60, INVALID, 0, 49},
+                      {0, 1, 1, 1, 1}}),
+    [](const ::testing::TestParamInfo<ThresholdCase> &info) { return std::string(info.param.name); });
+
+TEST(Sen6xThresholdRules, SteadyStateCycleWithRulesDoesNotAllocate) {
+  TestSEN5XComponent sen;
+  sensor::Sensor co2;
+  sen.set_co2_sensor(&co2);
+  // rules are registered from generated code before setup, as on the device
+  ThresholdTrigger above(&sen, CHANNEL_CO2, THRESHOLD_ABOVE, 1200, 100);
+  ThresholdTrigger rate(&sen, CHANNEL_PM_2_5, THRESHOLD_RATE_OF_CHANGE, 50, 0);
+
+  sen.prepare_setup_responses();
+  const uint16_t low[9] = {10, 20, 30, 40, 5000, 4000, 100, 10, 800};
+  const uint16_t high[9] = {10, 120, 130, 140, 5000, 4000, 100, 10, 1500};
+  sen.set_measurement_response(low);
+  sen.setup();
+  sen.run_pending_timeouts();
+  ASSERT_FALSE(sen.is_failed());
+  sen.run_cycle();
+
+  allocation_count = 0;
+  count_allocations = true;
+  for (int i = 0; i < 10; i++) {
+    sen.set_measurement_response(i % 2 ? high : low);
+    sen.run_cycle();
+  }
+  count_allocations = false;
+
+  EXPECT_EQ(allocation_count, 0u);
+  EXPECT_EQ(above.fired(), 5u);
+  EXPECT_EQ(rate.fired(), 5u);
+}
+
+}  // namespace testing
+}  // namespace sen6x
+}  // namespace esphome